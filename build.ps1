@@ -51,4 +51,5 @@ CheckReturnCodeOfPreviousCommand "tests failed"
 Info "Copy the header file to the publish directory and archive it"
 New-Item $buildDir/publish -Force -ItemType "directory" > $null
 Copy-Item -Path $buildDir/out/DsmrParser/DsmrParser/DsmrParser.h -Destination $buildDir/publish/DsmrParser.h
-Compress-Archive -Force -Path $buildDir/publish/DsmrParser.h -DestinationPath $buildDir/publish/DsmrParser.h.zip
+Copy-Item -Path $root/src/DsmrParser/DsmrEpollReader.h -Destination $buildDir/publish/DsmrEpollReader.h
+Compress-Archive -Force -Path $buildDir/publish/DsmrParser.h, $buildDir/publish/DsmrEpollReader.h -DestinationPath $buildDir/publish/DsmrParser.h.zip
@@ -0,0 +1,236 @@
+#pragma once
+#ifndef __linux__
+#error "DsmrEpollReader.h requires Linux (epoll)"
+#endif
+#include "DsmrParser.h"
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace DsmrParser {
+
+struct IDsmrPacketHandler {
+  virtual void OnPacket(const IPacket& packet) = 0;
+};
+
+// Packet latency is the time between the read() that delivered the '/' of a packet and the moment the receiver completed the packet,
+// so it covers the time the bytes waited in the read buffer and the processing of the packet
+struct DsmrReaderStatistics {
+  uint64_t bytesRead = 0;
+  uint64_t readCalls = 0;
+  uint64_t packetsReceived = 0;
+  uint64_t firstReadTimeNs = 0;
+  uint64_t lastReadTimeNs = 0;
+  uint64_t lastPacketLatencyNs = 0;
+  uint64_t minPacketLatencyNs = UINT64_MAX;
+  uint64_t maxPacketLatencyNs = 0;
+  uint64_t totalPacketLatencyNs = 0;
+
+  [[nodiscard]] uint64_t AveragePacketLatencyNs() const { return packetsReceived == 0 ? 0 : totalPacketLatencyNs / packetsReceived; }
+
+  [[nodiscard]] double BytesPerSecond() const { return PerSecond(bytesRead); }
+
+  [[nodiscard]] double PacketsPerSecond() const { return PerSecond(packetsReceived); }
+
+private:
+  [[nodiscard]] double PerSecond(const uint64_t amount) const {
+    const auto& elapsedNs = lastReadTimeNs - firstReadTimeNs;
+    return elapsedNs == 0 ? 0 : static_cast<double>(amount) * 1e9 / static_cast<double>(elapsedNs);
+  }
+};
+
+[[nodiscard]] inline uint64_t MonotonicTimeNs() {
+  timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return static_cast<uint64_t>(time.tv_sec) * 1000000000 + static_cast<uint64_t>(time.tv_nsec);
+}
+
+// Puts a serial port into raw 8N1 mode (DSMR 5 uses 115200 baud) with VTIME 0.
+// epoll reports the non-blocking port readable only once vmin bytes are buffered, which batches the reads. The last bytes of a
+// telegram (CRC and "\r\n") then wait for the next telegram, about a second later, if fewer than vmin of them remain, and that delay
+// shows up in the packet latency. VTIME is not configurable: under epoll it does not batch, with VTIME > 0 the port is reported
+// readable as soon as one byte arrives.
+// vmin 0 is rejected: a read() then returns 0 when the port is drained, which DsmrFdReader takes for a closed descriptor.
+[[nodiscard]] inline bool ConfigureSerialPort(const int fd, const uint8_t vmin = 1, const speed_t baudRate = B115200) {
+  if (vmin == 0) {
+    return false;
+  }
+
+  termios options;
+  if (tcgetattr(fd, &options) != 0) {
+    return false;
+  }
+
+  cfmakeraw(&options);
+  options.c_cflag &= ~(CSTOPB | CRTSCTS);
+  options.c_cflag |= CLOCAL | CREAD;
+  options.c_iflag &= ~(IXOFF | IXANY);
+  options.c_cc[VMIN] = vmin;
+  options.c_cc[VTIME] = 0;
+  if (cfsetispeed(&options, baudRate) != 0 || cfsetospeed(&options, baudRate) != 0) {
+    return false;
+  }
+
+  return tcsetattr(fd, TCSANOW, &options) == 0;
+}
+
+struct IFdReader {
+  [[nodiscard]] virtual int Fd() const = 0;
+
+  // Returns false when the descriptor is closed or failed
+  virtual bool OnReadable() = 0;
+};
+
+// Feeds the data of a tty, pipe or socket descriptor to a DsmrPacketReceiver.
+// A tty must have VMIN > 0 (see ConfigureSerialPort), because a 0-byte read() is treated as end of file.
+// Reads up to ReadSize bytes per read() call and at most maxReadsPerWakeUp times per OnReadable call, so a descriptor that is flooded
+// with data can't starve the other descriptors of the loop.
+// The descriptor is not owned and has to be non-blocking (DsmrEpollLoop::Add takes care of that).
+template <size_t BufferSize, size_t ReadSize = 4096> class DsmrFdReader : public IFdReader, private NonCopyableAndNonMovable {
+  static_assert(ReadSize > 0, "ReadSize must be positive");
+  static const int maxReadsPerWakeUp = 4;
+
+  const int fd;
+  IDsmrPacketHandler& handler;
+  DsmrPacketReceiver<BufferSize> receiver;
+  DsmrReaderStatistics statistics;
+  std::array<char, ReadSize> readBuffer;
+  uint64_t packetStartTimeNs = 0;
+  bool closed = false;
+
+public:
+  DsmrFdReader(const int fd, IDsmrPacketHandler& handler) : fd(fd), handler(handler) {}
+
+  [[nodiscard]] int Fd() const override { return fd; }
+
+  [[nodiscard]] bool IsClosed() const { return closed; }
+
+  [[nodiscard]] const DsmrReaderStatistics& Statistics() const { return statistics; }
+
+  void ResetStatistics() { statistics = DsmrReaderStatistics(); }
+
+  bool OnReadable() override {
+    for (int amountOfReads = 0; amountOfReads < maxReadsPerWakeUp;) {
+      const auto& amountRead = read(fd, readBuffer.data(), readBuffer.size());
+
+      if (amountRead > 0) {
+        amountOfReads++;
+        ProcessBytes(static_cast<size_t>(amountRead), MonotonicTimeNs());
+
+        // The epoll loop is level-triggered, so a short read means the descriptor is drained and another read() call can be saved
+        if (static_cast<size_t>(amountRead) < readBuffer.size()) {
+          return true;
+        }
+        continue;
+      }
+
+      if (amountRead < 0 && errno == EINTR) {
+        continue;
+      }
+
+      if (amountRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return true;
+      }
+
+      // End of file, or EIO when the other side of a pseudo-terminal is closed
+      closed = true;
+      return false;
+    }
+
+    // The epoll loop is level-triggered and reports the rest on the next Poll
+    return true;
+  }
+
+private:
+  void ProcessBytes(const size_t size, const uint64_t nowNs) {
+    if (statistics.readCalls == 0) {
+      statistics.firstReadTimeNs = nowNs;
+    }
+    statistics.lastReadTimeNs = nowNs;
+    statistics.readCalls++;
+    statistics.bytesRead += size;
+
+    for (size_t i = 0; i < size; i++) {
+      const auto& byte = readBuffer[i];
+      if (byte == '/') {
+        packetStartTimeNs = nowNs;
+      }
+
+      const auto& packet = receiver.ProcessByte(byte);
+      if (packet != nullptr) {
+        AddPacketLatency(MonotonicTimeNs() - packetStartTimeNs);
+        handler.OnPacket(*packet);
+      }
+    }
+  }
+
+  void AddPacketLatency(const uint64_t latencyNs) {
+    statistics.packetsReceived++;
+    statistics.lastPacketLatencyNs = latencyNs;
+    statistics.totalPacketLatencyNs += latencyNs;
+    if (latencyNs < statistics.minPacketLatencyNs) {
+      statistics.minPacketLatencyNs = latencyNs;
+    }
+    if (latencyNs > statistics.maxPacketLatencyNs) {
+      statistics.maxPacketLatencyNs = latencyNs;
+    }
+  }
+};
+
+// Level-triggered epoll loop over any number of readers
+class DsmrEpollLoop : private NonCopyableAndNonMovable {
+  const int epollFd;
+
+public:
+  DsmrEpollLoop() : epollFd(epoll_create1(EPOLL_CLOEXEC)) {}
+
+  ~DsmrEpollLoop() {
+    if (epollFd >= 0) {
+      close(epollFd);
+    }
+  }
+
+  [[nodiscard]] bool IsValid() const { return epollFd >= 0; }
+
+  // Makes the descriptor non-blocking and starts watching it
+  [[nodiscard]] bool Add(IFdReader& reader) {
+    const auto& flags = fcntl(reader.Fd(), F_GETFL);
+    if (flags < 0 || fcntl(reader.Fd(), F_SETFL, flags | O_NONBLOCK) != 0) {
+      return false;
+    }
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.ptr = &reader;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, reader.Fd(), &event) == 0;
+  }
+
+  bool Remove(IFdReader& reader) { return epoll_ctl(epollFd, EPOLL_CTL_DEL, reader.Fd(), nullptr) == 0; }
+
+  // Waits up to timeoutMs (-1 waits forever) and lets every ready reader read from its descriptor.
+  // Readers whose descriptor got closed are removed from the loop.
+  // Returns the amount of ready readers, or -1 if epoll_wait failed.
+  int Poll(const int timeoutMs) {
+    std::array<epoll_event, 16> events;
+    const auto& amountReady = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeoutMs);
+    if (amountReady < 0) {
+      return errno == EINTR ? 0 : -1;
+    }
+
+    for (int i = 0; i < amountReady; i++) {
+      auto& reader = *static_cast<IFdReader*>(events[i].data.ptr);
+      if (!reader.OnReadable()) {
+        Remove(reader);
+      }
+    }
+    return amountReady;
+  }
+};
+
+}
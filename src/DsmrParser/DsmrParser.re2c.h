@@ -3,6 +3,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 namespace DsmrParser {
 
@@ -46,8 +47,22 @@ public:
   friend bool operator!=(const StringView& lhs, const char* rhs) { return !(lhs == rhs); }
 };
 
+[[nodiscard]] inline uint16_t CalculateCrc16(const char* data, size_t length) {
+  uint16_t crc = 0;
+  while (length--) {
+    crc ^= static_cast<char>(*data++);
+    for (int i = 0; i < 8; ++i) {
+      if (crc & 1)
+        crc = (crc >> 1) ^ 0xa001;
+      else
+        crc = (crc >> 1);
+    }
+  }
+  return crc;
+}
+
 struct IPacket {
-  virtual [[nodiscard]] StringView Data() const = 0;
+  [[nodiscard]] virtual StringView Data() const = 0;
 };
 
 struct IState {
@@ -60,10 +75,10 @@ struct IStateContext {
 
 class IPacketBuffer : public IPacket {
 public:
-  virtual [[nodiscard]] void Add(char byte) = 0;
-  virtual [[nodiscard]] bool HasSpace() const = 0;
-  virtual [[nodiscard]] uint16_t CalculateCrc16() const = 0;
-  virtual [[nodiscard]] void Reset() = 0;
+  virtual void Add(char byte) = 0;
+  [[nodiscard]] virtual bool HasSpace() const = 0;
+  [[nodiscard]] virtual uint16_t CalculateCrc16() const = 0;
+  virtual void Reset() = 0;
 };
 
 template <size_t size> class PacketBuffer : public IPacketBuffer, private NonCopyableAndNonMovable {
@@ -83,21 +98,7 @@ public:
 
   [[nodiscard]] bool HasSpace() const override { return packetSize < buffer.size(); }
 
-  [[nodiscard]] uint16_t CalculateCrc16() const override {
-    uint16_t crc = 0;
-    auto length = packetSize;
-    const char* data = buffer.data();
-    while (length--) {
-      crc ^= static_cast<char>(*data++);
-      for (int i = 0; i < 8; ++i) {
-        if (crc & 1)
-          crc = (crc >> 1) ^ 0xa001;
-        else
-          crc = (crc >> 1);
-      }
-    }
-    return crc;
-  }
+  [[nodiscard]] uint16_t CalculateCrc16() const override { return DsmrParser::CalculateCrc16(buffer.data(), packetSize); }
 
   [[nodiscard]] StringView Data() const override { return StringView(buffer.data(), packetSize); }
 };
@@ -246,6 +247,26 @@ struct IDsmrParserResultReceiver {
   virtual void OnDsmrData(const DsmrDataObject& dsmrData) = 0;
 };
 
+enum class ParseStatus { MorePending, Done };
+
+// Position of a resumable parse between DsmrPacketParser::Parse calls.
+// The lexer tags are only used inside a single match, so the cursor is the only state that has to be kept.
+// The cursor points into the packet data, so the packet must stay unchanged until Parse returns Done.
+class DsmrParseContext {
+  friend class DsmrPacketParser;
+  const char* cursor = nullptr;
+  const char* limit = nullptr;
+
+public:
+  DsmrParseContext() = default;
+  DsmrParseContext(const IPacket& packet) { Reset(packet); }
+
+  void Reset(const IPacket& packet) {
+    cursor = packet.Data().Data();
+    limit = cursor + packet.Data().Size();
+  }
+};
+
 class DsmrPacketParser : private NonCopyableAndNonMovable {
 private:
   IDsmrParserResultReceiver& dataReceiver;
@@ -253,10 +274,20 @@ private:
 public:
   DsmrPacketParser(IDsmrParserResultReceiver& dataReceiver) : dataReceiver(dataReceiver) {}
 
+#ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4101) // unreferenced local variable
 #pragma warning(disable : 4189) // local variable is initialized but not referenced
 #pragma warning(disable : 4701) // potentially uninitialized local variable
+#pragma warning(disable : 4127) // conditional expression is constant
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#ifndef __clang__
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
   [[nodiscard]] bool ParseHeader(const IPacket& packet, DsmrPacketHeader& header) {
     const char* YYCURSOR = (char*)packet.Data().Data();
     const char* YYMARKER;
@@ -272,7 +303,7 @@ public:
         re2c:tags = 1;
 
         [/] @t1 .{4} @t2 .+ @t3 [\r][\n] {
-          strncpy(header.version, t1, 4);
+          memcpy(header.version, t1, sizeof(header.version));
           header.identification = StringView(t2, t3 - t2);
           return true;
         }
@@ -281,9 +312,26 @@ public:
   }
 
   void Parse(const IPacket& packet) {
-    const char* YYCURSOR = (char*)packet.Data().Data();
+    DsmrParseContext ctx(packet);
+    (void)ParseObjects<false>(ctx, 0, 0);
+  }
+
+  // Resumable version of Parse. Call again with the same context while MorePending is returned.
+  // The budget is checked after every token, which is either an object line or a single skipped byte, so an object line can exceed
+  // `maxBytes`. Every call consumes at least one token, so a budget of 0 still makes progress.
+  // The packet must stay unchanged until Done is returned. A DsmrPacketReceiver overwrites its packet on the next '/', so don't feed
+  // it more bytes while the parse of its packet is spread over several calls.
+  [[nodiscard]] ParseStatus Parse(DsmrParseContext& ctx, const size_t maxBytes, const size_t maxObjects) {
+    return ParseObjects<true>(ctx, maxBytes, maxObjects);
+  }
+
+private:
+  // The one-shot Parse uses isBudgeted == false, which compiles the budget checks out of the per token loop
+  template <bool isBudgeted> ParseStatus ParseObjects(DsmrParseContext& ctx, const size_t maxBytes, const size_t maxObjects) {
+    const char* YYCURSOR = ctx.cursor;
     const char* YYMARKER;
-    const char* YYLIMIT = YYCURSOR + packet.Data().Size();
+    const char* YYLIMIT = ctx.limit;
+    const char* budgetEnd = maxBytes < static_cast<size_t>(YYLIMIT - YYCURSOR) ? YYCURSOR + maxBytes : YYLIMIT;
     const char* t1 = nullptr;
     const char* t2 = nullptr;
     const char* t3 = nullptr;
@@ -298,8 +346,21 @@ public:
     const char* t12 = nullptr;
     const char* t13 = nullptr;
     const char* t14 = nullptr;
+    size_t amountOfObjectsParsed = 0;
+
+    for (bool isFirstToken = true;; isFirstToken = false) {
+      if (isBudgeted) {
+        if (YYCURSOR >= YYLIMIT) {
+          ctx.cursor = YYCURSOR;
+          return ParseStatus::Done;
+        }
+
+        if (!isFirstToken && (YYCURSOR >= budgetEnd || amountOfObjectsParsed >= maxObjects)) {
+          ctx.cursor = YYCURSOR;
+          return ParseStatus::MorePending;
+        }
+      }
 
-    for (;;) {
       /*!stags:re2c format = 'const char *@@;\n'; */
       /*!re2c
           re2c:define:YYCTYPE = char;
@@ -322,14 +383,24 @@ public:
               dsmrData.unit = StringView(t13, t14 - t13);
             }
             dataReceiver.OnDsmrData(dsmrData);
+            amountOfObjectsParsed++;
+            continue;
+          }
+          [\!] {
+            ctx.cursor = YYLIMIT;
+            return ParseStatus::Done;
           }
-          [\!] { return; }
           * { continue; }
       */
     }
   }
+#ifdef _MSC_VER
 #pragma warning(pop)
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
 
+public:
   static uint8_t StringToNumber(const char* startPosition, const char* endPosition) {
     uint8_t n = 0;
     for (; startPosition < endPosition; startPosition++) {
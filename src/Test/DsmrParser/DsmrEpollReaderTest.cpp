@@ -0,0 +1,203 @@
+#ifdef __linux__
+#include "DsmrParser/DsmrEpollReader.h"
+#include "DsmrTelegramGenerator.h"
+#include <cstdlib>
+#include <doctest.h>
+#include <functional>
+#include <sys/socket.h>
+using namespace DsmrParser;
+
+class DsmrPacketHandlerMock : public IDsmrPacketHandler {
+public:
+  size_t packetsReceived = 0;
+  size_t lastPacketSize = 0;
+
+  void OnPacket(const IPacket& packet) override {
+    packetsReceived++;
+    lastPacketSize = packet.Data().Size();
+  }
+};
+
+// Plays the role of the meter
+class FdTelegramSink : public ITelegramSink {
+  const int fd;
+
+public:
+  FdTelegramSink(const int fd) : fd(fd) {}
+
+  bool Write(const char* data, size_t size) override {
+    while (size > 0) {
+      const auto& amountWritten = write(fd, data, size);
+      if (amountWritten <= 0) {
+        return false;
+      }
+      data += amountWritten;
+      size -= static_cast<size_t>(amountWritten);
+    }
+    return true;
+  }
+};
+
+static void PollUntil(DsmrEpollLoop& loop, const std::function<bool()>& condition) {
+  for (int i = 0; i < 100 && !condition(); i++) {
+    REQUIRE(loop.Poll(100) >= 0);
+  }
+  REQUIRE(condition());
+}
+
+TEST_CASE("DsmrFdReader over a socket") {
+  int sockets[2];
+  REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+  FdTelegramSink meter(sockets[0]);
+  DsmrTelegramGenerator generator;
+  DsmrPacketHandlerMock handler;
+  DsmrFdReader<4000> reader(sockets[1], handler);
+  DsmrEpollLoop loop;
+  REQUIRE(loop.IsValid());
+  REQUIRE(loop.Add(reader));
+
+  SUBCASE("Receive telegrams in batches") {
+    for (size_t i = 1; i <= 10; i++) {
+      REQUIRE(generator.Write(meter, 10, 5, TelegramCorruption::BitFlip));
+      PollUntil(loop, [&] { return handler.packetsReceived == i * 8; });
+    }
+
+    const auto& statistics = reader.Statistics();
+    REQUIRE(statistics.packetsReceived == 80);
+    REQUIRE(statistics.readCalls * 100 < statistics.bytesRead);
+    REQUIRE(statistics.BytesPerSecond() > 0);
+    REQUIRE(statistics.PacketsPerSecond() > 0);
+    REQUIRE(statistics.AveragePacketLatencyNs() > 0);
+    REQUIRE(statistics.minPacketLatencyNs > 0);
+    REQUIRE(handler.lastPacketSize > 0);
+  }
+
+  SUBCASE("Latency of a telegram split across two reads") {
+    const auto& telegram = generator.Next();
+    const auto& half = telegram.Size() / 2;
+
+    REQUIRE(meter.Write(telegram.Data(), half));
+    REQUIRE(loop.Poll(1000) == 1);
+    REQUIRE(handler.packetsReceived == 0);
+
+    usleep(20000);
+    REQUIRE(meter.Write(telegram.Data() + half, telegram.Size() - half));
+    PollUntil(loop, [&] { return handler.packetsReceived == 1; });
+
+    const auto& statistics = reader.Statistics();
+    REQUIRE(statistics.readCalls == 2);
+    REQUIRE(statistics.bytesRead == telegram.Size());
+    REQUIRE(statistics.lastPacketLatencyNs >= 20000000);
+    REQUIRE(statistics.lastPacketLatencyNs >= statistics.lastReadTimeNs - statistics.firstReadTimeNs);
+    REQUIRE(statistics.minPacketLatencyNs == statistics.lastPacketLatencyNs);
+    REQUIRE(statistics.maxPacketLatencyNs == statistics.lastPacketLatencyNs);
+  }
+
+  SUBCASE("Closed connection removes the reader") {
+    close(sockets[0]);
+    sockets[0] = -1;
+    REQUIRE(loop.Poll(1000) == 1);
+    REQUIRE(reader.IsClosed());
+    REQUIRE(loop.Poll(0) == 0);
+  }
+
+  if (sockets[0] >= 0) {
+    close(sockets[0]);
+  }
+  close(sockets[1]);
+}
+
+TEST_CASE("DsmrEpollLoop with a flooded descriptor") {
+  int floodedPipe[2];
+  int meterPipe[2];
+  REQUIRE(pipe(floodedPipe) == 0);
+  REQUIRE(pipe(meterPipe) == 0);
+  DsmrPacketHandlerMock floodedHandler;
+  DsmrPacketHandlerMock meterHandler;
+  DsmrFdReader<4000> floodedReader(floodedPipe[0], floodedHandler);
+  DsmrFdReader<4000> meterReader(meterPipe[0], meterHandler);
+  DsmrEpollLoop loop;
+  REQUIRE(loop.Add(floodedReader));
+  REQUIRE(loop.Add(meterReader));
+
+  // Fill the flooded pipe until it is full
+  REQUIRE(fcntl(floodedPipe[1], F_SETFL, O_NONBLOCK) == 0);
+  const std::array<char, 4096> garbage = {};
+  size_t bytesFlooded = 0;
+  for (ssize_t amountWritten; (amountWritten = write(floodedPipe[1], garbage.data(), garbage.size())) > 0;) {
+    bytesFlooded += static_cast<size_t>(amountWritten);
+  }
+  REQUIRE(bytesFlooded > 4 * 4096);
+
+  DsmrTelegramGenerator generator;
+  FdTelegramSink meter(meterPipe[1]);
+  REQUIRE(generator.Write(meter, 1));
+
+  REQUIRE(loop.Poll(1000) == 2);
+  REQUIRE(meterHandler.packetsReceived == 1);
+  REQUIRE(floodedReader.Statistics().readCalls == 4);
+  REQUIRE(floodedReader.Statistics().bytesRead < bytesFlooded);
+
+  PollUntil(loop, [&] { return floodedReader.Statistics().bytesRead == bytesFlooded; });
+
+  for (const auto& fd : {floodedPipe[0], floodedPipe[1], meterPipe[0], meterPipe[1]}) {
+    close(fd);
+  }
+}
+
+TEST_CASE("DsmrFdReader over a pseudo-terminal") {
+  const int master = posix_openpt(O_RDWR | O_NOCTTY);
+  REQUIRE(master >= 0);
+  REQUIRE(grantpt(master) == 0);
+  REQUIRE(unlockpt(master) == 0);
+  const int serialPort = open(ptsname(master), O_RDWR | O_NOCTTY);
+  REQUIRE(serialPort >= 0);
+
+  FdTelegramSink meter(master);
+  DsmrTelegramGenerator generator;
+  DsmrPacketHandlerMock handler;
+  DsmrFdReader<4000> reader(serialPort, handler);
+  DsmrEpollLoop loop;
+  REQUIRE(loop.Add(reader));
+
+  SUBCASE("Receive telegrams") {
+    REQUIRE(ConfigureSerialPort(serialPort));
+    REQUIRE(generator.Write(meter, 3));
+    PollUntil(loop, [&] { return handler.packetsReceived == 3; });
+  }
+
+  SUBCASE("Serial port is configured as 8N1 without flow control") {
+    termios options;
+    REQUIRE(tcgetattr(serialPort, &options) == 0);
+    options.c_cflag |= CSTOPB | CRTSCTS;
+    options.c_iflag |= IXOFF | IXANY;
+    REQUIRE(tcsetattr(serialPort, TCSANOW, &options) == 0);
+
+    REQUIRE(ConfigureSerialPort(serialPort));
+    REQUIRE(tcgetattr(serialPort, &options) == 0);
+    REQUIRE((options.c_cflag & (CSTOPB | CRTSCTS | PARENB)) == 0);
+    REQUIRE((options.c_cflag & CSIZE) == CS8);
+    REQUIRE((options.c_iflag & (IXON | IXOFF | IXANY)) == 0);
+  }
+
+  SUBCASE("VMIN 0 is rejected") {
+    REQUIRE(ConfigureSerialPort(serialPort, 0) == false);
+  }
+
+  SUBCASE("VMIN batches the reads") {
+    REQUIRE(ConfigureSerialPort(serialPort, 16));
+    const char data[] = "0123456789ABCDEF";
+
+    REQUIRE(meter.Write(data, 8));
+    REQUIRE(loop.Poll(100) == 0);
+
+    REQUIRE(meter.Write(data + 8, 8));
+    REQUIRE(loop.Poll(1000) == 1);
+    REQUIRE(reader.Statistics().readCalls == 1);
+    REQUIRE(reader.Statistics().bytesRead == 16);
+  }
+
+  close(master);
+  close(serialPort);
+}
+#endif
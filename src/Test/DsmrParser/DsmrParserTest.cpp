@@ -1,4 +1,5 @@
 #include "DsmrParser/DsmrParser.h"
+#include "DsmrTelegramGenerator.h"
 #include <cstdio>
 #include <doctest.h>
 #include <functional>
@@ -94,3 +95,75 @@ TEST_CASE("DsmrPacketParser") {
     REQUIRE(dataObjects[2].unit == "kWh");
   }
 }
+
+static bool IsSameObject(const DsmrDataObject& lhs, const DsmrDataObject& rhs) {
+  return lhs.obisCode.A == rhs.obisCode.A && lhs.obisCode.B == rhs.obisCode.B && lhs.obisCode.C == rhs.obisCode.C &&
+         lhs.obisCode.D == rhs.obisCode.D && lhs.obisCode.E == rhs.obisCode.E && lhs.value.Data() == rhs.value.Data() &&
+         lhs.value.Size() == rhs.value.Size() && lhs.unit.Data() == rhs.unit.Data() && lhs.unit.Size() == rhs.unit.Size();
+}
+
+TEST_CASE("DsmrPacketParser resumable Parse") {
+  DsmrParserResultReceiverMock resultReceiver;
+  DsmrPacketParser parser(resultReceiver);
+  DsmrTelegramGeneratorConfig config;
+  config.mbusChannels = 4;
+  config.powerFailures = 10;
+  DsmrTelegramGenerator generator(config);
+  const auto& telegram = generator.Next();
+  PacketMock packetMock(telegram.Data(), telegram.Size());
+
+  std::vector<DsmrDataObject> expectedObjects;
+  resultReceiver.SetCallback([&](const DsmrDataObject& dsmrData) { expectedObjects.push_back(dsmrData); });
+  parser.Parse(packetMock);
+  REQUIRE(expectedObjects.size() == generator.ParsableObjectCount());
+
+  std::vector<DsmrDataObject> dataObjects;
+  resultReceiver.SetCallback([&](const DsmrDataObject& dsmrData) { dataObjects.push_back(dsmrData); });
+
+  SUBCASE("Byte budget") {
+    for (const size_t maxBytes : {1, 7, 64, 512}) {
+      dataObjects.clear();
+      DsmrParseContext ctx(packetMock);
+      size_t calls = 1;
+      while (parser.Parse(ctx, maxBytes, SIZE_MAX) == ParseStatus::MorePending) {
+        calls++;
+      }
+      REQUIRE(calls > 1);
+      REQUIRE(dataObjects.size() == expectedObjects.size());
+      for (size_t i = 0; i < dataObjects.size(); i++) {
+        REQUIRE(IsSameObject(dataObjects[i], expectedObjects[i]));
+      }
+    }
+  }
+
+  SUBCASE("Object budget") {
+    DsmrParseContext ctx(packetMock);
+    for (size_t i = 0; i < expectedObjects.size(); i++) {
+      REQUIRE(parser.Parse(ctx, SIZE_MAX, 1) == ParseStatus::MorePending);
+      REQUIRE(dataObjects.size() == i + 1);
+      REQUIRE(IsSameObject(dataObjects[i], expectedObjects[i]));
+    }
+    REQUIRE(parser.Parse(ctx, SIZE_MAX, 1) == ParseStatus::Done);
+    REQUIRE(dataObjects.size() == expectedObjects.size());
+  }
+
+  SUBCASE("Zero budget makes progress") {
+    DsmrParseContext ctx(packetMock);
+    size_t calls = 1;
+    while (parser.Parse(ctx, 0, 0) == ParseStatus::MorePending) {
+      calls++;
+      REQUIRE(calls <= telegram.Size());
+    }
+    REQUIRE(dataObjects.size() == expectedObjects.size());
+    for (size_t i = 0; i < dataObjects.size(); i++) {
+      REQUIRE(IsSameObject(dataObjects[i], expectedObjects[i]));
+    }
+  }
+
+  SUBCASE("Done is returned after the end of the packet") {
+    DsmrParseContext ctx(packetMock);
+    REQUIRE(parser.Parse(ctx, SIZE_MAX, SIZE_MAX) == ParseStatus::Done);
+    REQUIRE(parser.Parse(ctx, SIZE_MAX, SIZE_MAX) == ParseStatus::Done);
+    REQUIRE(dataObjects.size() == expectedObjects.size());
+  }
+}
@@ -0,0 +1,426 @@
+#pragma once
+#include "DsmrParser/DsmrParser.h"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace DsmrParser {
+
+enum class VendorHeaderStyle { Kaifa, Iskra, LandisGyr, Sagemcom };
+
+enum class TelegramCorruption {
+  None,
+  BitFlip,          // One bit of the telegram body is flipped. The CRC no longer matches.
+  Truncation,       // The telegram is cut before the last CRC digit
+  StrayStartSymbol, // A '/' is inserted in the middle of the telegram body
+  Oversize          // Filler lines are added so the telegram exceeds DsmrTelegramGeneratorConfig::oversizeFrameSize. The CRC stays valid.
+};
+
+struct TelegramObjectTemplate {
+  ObisCode obisCode;
+  uint8_t integerDigits;
+  uint8_t fractionDigits;
+  const char* unit; // nullptr for values without a unit
+};
+
+inline std::vector<TelegramObjectTemplate> DefaultTelegramObjects() {
+  return {
+      {{1, 0, 1, 8, 1}, 6, 3, "kWh"}, {{1, 0, 1, 8, 2}, 6, 3, "kWh"}, {{1, 0, 2, 8, 1}, 6, 3, "kWh"}, {{1, 0, 2, 8, 2}, 6, 3, "kWh"},
+      {{0, 0, 96, 14, 0}, 4, 0, nullptr}, {{1, 0, 1, 7, 0}, 2, 3, "kW"},   {{1, 0, 2, 7, 0}, 2, 3, "kW"},   {{0, 0, 96, 7, 21}, 5, 0, nullptr},
+      {{0, 0, 96, 7, 9}, 5, 0, nullptr},  {{1, 0, 32, 32, 0}, 5, 0, nullptr}, {{1, 0, 32, 36, 0}, 5, 0, nullptr}, {{1, 0, 32, 7, 0}, 3, 1, "V"},
+      {{1, 0, 31, 7, 0}, 3, 0, "A"},      {{1, 0, 21, 7, 0}, 2, 3, "kW"},  {{1, 0, 22, 7, 0}, 2, 3, "kW"}};
+}
+
+struct DsmrTelegramGeneratorConfig {
+  VendorHeaderStyle headerStyle = VendorHeaderStyle::Sagemcom;
+  std::vector<TelegramObjectTemplate> objects = DefaultTelegramObjects();
+  uint8_t mbusChannels = 1;
+  uint8_t powerFailures = 3;
+  size_t oversizeFrameSize = 4000;
+  uint32_t seed = 1;
+};
+
+struct ITelegramSink {
+  virtual bool Write(const char* data, size_t size) = 0;
+};
+
+// Writes telegrams to a file, pipe or stdout
+class FileTelegramSink : public ITelegramSink, private NonCopyableAndNonMovable {
+  FILE* file;
+
+public:
+  FileTelegramSink(FILE* file) : file(file) {}
+
+  bool Write(const char* data, size_t size) override { return fwrite(data, 1, size, file) == size; }
+};
+
+// Generates valid DSMR telegrams and, on request, corrupted ones.
+// The telegram layout is built once in the constructor. Generating a telegram only rewrites the timestamp and the values in place and
+// recalculates the CRC, so no memory is allocated after the first telegram of each corruption kind.
+// Values grow with every telegram, timestamps advance by one second per telegram. Months are 28 days long, so the timestamps are
+// well-formed but not calendar accurate.
+class DsmrTelegramGenerator : private NonCopyableAndNonMovable {
+  struct Field {
+    size_t offset;
+    uint8_t integerDigits;
+    uint8_t fractionDigits;
+    uint64_t modulo;
+    uint64_t value;
+    uint64_t step;
+  };
+
+  static const uint32_t startTime = 400 * 86400 + 9 * 3600 + 4 * 60 + 42;
+
+  DsmrTelegramGeneratorConfig config;
+  std::array<std::array<uint16_t, 256>, 8> crcTable;
+  std::string telegram;
+  std::string corrupted;
+  std::vector<size_t> timestamps;
+  std::vector<Field> fields;
+  size_t parsableObjectCount = 0;
+  uint64_t sequence = 0;
+  uint32_t randomState;
+
+public:
+  DsmrTelegramGenerator(const DsmrTelegramGeneratorConfig& config = DsmrTelegramGeneratorConfig())
+      : config(config), randomState(config.seed != 0 ? config.seed : 1) {
+    BuildCrcTable();
+    BuildTelegram();
+  }
+
+  // Returns the next telegram. The data stays valid until the next call.
+  [[nodiscard]] StringView Next(const TelegramCorruption corruption = TelegramCorruption::None) {
+    UpdateFields();
+    sequence++;
+
+    switch (corruption) {
+    case TelegramCorruption::None:
+      return StringView(telegram.data(), telegram.size());
+    case TelegramCorruption::BitFlip:
+      return FlipBit();
+    case TelegramCorruption::Truncation:
+      return Truncate();
+    case TelegramCorruption::StrayStartSymbol:
+      return InsertStrayStartSymbol();
+    case TelegramCorruption::Oversize:
+      return MakeOversize();
+    }
+    return StringView();
+  }
+
+  // Writes `count` telegrams to the sink. Every `corruptEvery`-th telegram gets the `corruption` applied (0 disables corruption).
+  [[nodiscard]] bool Write(ITelegramSink& sink, size_t count, const size_t corruptEvery = 0,
+                           const TelegramCorruption corruption = TelegramCorruption::None) {
+    for (; count > 0; count--) {
+      const auto& isCorrupted = corruptEvery != 0 && (sequence + 1) % corruptEvery == 0;
+      const auto& data = Next(isCorrupted ? corruption : TelegramCorruption::None);
+      if (!sink.Write(data.Data(), data.Size())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Amount of objects DsmrPacketParser::Parse reports for every valid telegram
+  [[nodiscard]] size_t ParsableObjectCount() const { return parsableObjectCount; }
+
+  [[nodiscard]] uint64_t Sequence() const { return sequence; }
+
+  // Same result as DsmrParser::CalculateCrc16, but processes 8 bytes at a time (slicing-by-8).
+  // Blocks containing non-ASCII bytes go byte by byte to keep the sign extension of DsmrParser::CalculateCrc16.
+  [[nodiscard]] uint16_t CalculateCrc16(const char* data, size_t length) const {
+    uint16_t crc = 0;
+    for (; length >= 8; length -= 8, data += 8) {
+      uint64_t block;
+      memcpy(&block, data, sizeof(block));
+      if (block & 0x8080808080808080ull) {
+        crc = AddToCrc16(crc, data, 8);
+        continue;
+      }
+      const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+      crc = crcTable[7][(crc ^ bytes[0]) & 0xFF] ^ crcTable[6][((crc >> 8) ^ bytes[1]) & 0xFF] ^ crcTable[5][bytes[2]] ^ crcTable[4][bytes[3]] ^
+            crcTable[3][bytes[4]] ^ crcTable[2][bytes[5]] ^ crcTable[1][bytes[6]] ^ crcTable[0][bytes[7]];
+    }
+    return AddToCrc16(crc, data, length);
+  }
+
+private:
+  [[nodiscard]] uint16_t AddToCrc16(uint16_t crc, const char* data, size_t length) const {
+    while (length--) {
+      crc ^= static_cast<char>(*data++);
+      crc = (crc >> 8) ^ crcTable[0][crc & 0xFF];
+    }
+    return crc;
+  }
+
+  void BuildCrcTable() {
+    for (uint16_t i = 0; i < crcTable[0].size(); i++) {
+      uint16_t crc = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        if (crc & 1)
+          crc = (crc >> 1) ^ 0xa001;
+        else
+          crc = (crc >> 1);
+      }
+      crcTable[0][i] = crc;
+    }
+    for (size_t table = 1; table < crcTable.size(); table++) {
+      for (size_t i = 0; i < crcTable[table].size(); i++) {
+        crcTable[table][i] = (crcTable[table - 1][i] >> 8) ^ crcTable[0][crcTable[table - 1][i] & 0xFF];
+      }
+    }
+  }
+
+  void BuildTelegram() {
+    telegram.append(Header());
+    telegram.append("\r\n\r\n1-3:0.2.8(50)\r\n");
+    AppendTimestampObject(ObisCode{0, 0, 1, 0, 0});
+    telegram.append("0-0:96.1.1(");
+    AppendEquipmentIdentifier(0);
+    telegram.append(")\r\n");
+    parsableObjectCount = 2;
+
+    for (const auto& object : config.objects) {
+      AppendObisCode(object.obisCode);
+      telegram.push_back('(');
+      AppendField(object.integerDigits, object.fractionDigits);
+      if (object.unit != nullptr) {
+        telegram.push_back('*');
+        telegram.append(object.unit);
+      }
+      telegram.append(")\r\n");
+      parsableObjectCount++;
+    }
+
+    AppendPowerFailureLog();
+    telegram.append("0-0:96.13.0()\r\n");
+
+    for (uint8_t channel = 1; channel <= config.mbusChannels && channel != 0; channel++) {
+      AppendObisCode(ObisCode{0, channel, 24, 1, 0});
+      telegram.append("(003)\r\n");
+      AppendObisCode(ObisCode{0, channel, 96, 1, 0});
+      telegram.push_back('(');
+      AppendEquipmentIdentifier(channel);
+      telegram.append(")\r\n");
+      AppendObisCode(ObisCode{0, channel, 24, 2, 1});
+      telegram.push_back('(');
+      timestamps.push_back(telegram.size());
+      telegram.append("000000000000W)(");
+      AppendField(5, 3);
+      telegram.append("*m3)\r\n");
+      parsableObjectCount += 2;
+    }
+
+    telegram.append("!0000\r\n");
+    corrupted.reserve(telegram.size() + config.oversizeFrameSize + 256);
+  }
+
+  [[nodiscard]] const char* Header() const {
+    switch (config.headerStyle) {
+    case VendorHeaderStyle::Kaifa:
+      return "/KFM5KAIFA-METER";
+    case VendorHeaderStyle::Iskra:
+      return "/ISk5\\2MT382-1000";
+    case VendorHeaderStyle::LandisGyr:
+      return "/XMX5LGF0010455163836";
+    case VendorHeaderStyle::Sagemcom:
+      return "/Ene5\\XS210 ESMR 5.0";
+    }
+    return "/XXX5";
+  }
+
+  void AppendObisCode(const ObisCode& obisCode) {
+    AppendNumber(obisCode.A);
+    telegram.push_back('-');
+    AppendNumber(obisCode.B);
+    telegram.push_back(':');
+    AppendNumber(obisCode.C);
+    telegram.push_back('.');
+    AppendNumber(obisCode.D);
+    telegram.push_back('.');
+    AppendNumber(obisCode.E);
+  }
+
+  void AppendNumber(const uint8_t number) {
+    if (number >= 100) {
+      telegram.push_back(static_cast<char>('0' + number / 100));
+    }
+    if (number >= 10) {
+      telegram.push_back(static_cast<char>('0' + number / 10 % 10));
+    }
+    telegram.push_back(static_cast<char>('0' + number % 10));
+  }
+
+  void AppendTimestampObject(const ObisCode& obisCode) {
+    AppendObisCode(obisCode);
+    telegram.push_back('(');
+    timestamps.push_back(telegram.size());
+    telegram.append("000000000000W)\r\n");
+  }
+
+  // Equipment identifiers are the hex encoded ASCII serial number, which only contains digits
+  void AppendEquipmentIdentifier(const uint8_t channel) {
+    for (int i = 0; i < 17; i++) {
+      telegram.push_back('3');
+      telegram.push_back(static_cast<char>('0' + (i == 0 ? channel % 10 : Random() % 10)));
+    }
+  }
+
+  void AppendField(uint8_t integerDigits, uint8_t fractionDigits) {
+    if (fractionDigits > 17) {
+      fractionDigits = 17;
+    }
+    if (integerDigits + fractionDigits > 18) {
+      integerDigits = 18 - fractionDigits;
+    }
+    if (integerDigits == 0) {
+      integerDigits = 1;
+    }
+
+    Field field;
+    field.offset = telegram.size();
+    field.integerDigits = integerDigits;
+    field.fractionDigits = fractionDigits;
+    field.modulo = 1;
+    for (int i = 0; i < integerDigits + fractionDigits; i++) {
+      field.modulo *= 10;
+    }
+    field.step = 1 + Random() % (field.modulo <= 1000 ? field.modulo - 1 : 1000);
+    const uint64_t high = Random();
+    const uint64_t low = Random();
+    field.value = (high << 32 | low) % field.modulo;
+    fields.push_back(field);
+
+    telegram.append(integerDigits + fractionDigits + (fractionDigits > 0 ? 1 : 0), '0');
+  }
+
+  void AppendPowerFailureLog() {
+    telegram.append("1-0:99.97.0(");
+    AppendNumber(config.powerFailures);
+    telegram.append(")(0-0:96.7.19)");
+    for (uint8_t i = 0; i < config.powerFailures; i++) {
+      telegram.push_back('(');
+      const auto& timestampOffset = telegram.size();
+      telegram.append("000000000000W)(");
+      WriteTimestamp(timestampOffset, startTime - Random() % (300 * 86400));
+      const auto& duration = Random() % 100000;
+      for (uint32_t divider = 1000000000; divider > 0; divider /= 10) {
+        telegram.push_back(static_cast<char>('0' + duration / divider % 10));
+      }
+      telegram.append("*s)");
+    }
+    telegram.append("\r\n");
+  }
+
+  void UpdateFields() {
+    const auto& now = startTime + sequence;
+    for (const auto& offset : timestamps) {
+      WriteTimestamp(offset, now);
+    }
+
+    for (auto& field : fields) {
+      field.value += field.step;
+      if (field.value >= field.modulo) {
+        field.value -= field.modulo;
+      }
+      auto value = field.value;
+      char* position = &telegram[field.offset + field.integerDigits + field.fractionDigits + (field.fractionDigits > 0 ? 1 : 0)];
+      for (int i = 0; i < field.fractionDigits; i++) {
+        *--position = static_cast<char>('0' + value % 10);
+        value /= 10;
+      }
+      if (field.fractionDigits > 0) {
+        *--position = '.';
+      }
+      for (int i = 0; i < field.integerDigits; i++) {
+        *--position = static_cast<char>('0' + value % 10);
+        value /= 10;
+      }
+    }
+
+    WriteCrc(telegram);
+  }
+
+  // Writes YYMMDDhhmmssX where X is 'S' for summer and 'W' for winter time
+  void WriteTimestamp(const size_t offset, const uint64_t seconds) {
+    const auto& days = seconds / 86400;
+    const auto& month = days / 28 % 12 + 1;
+    const uint64_t parts[] = {23 + days / 336 % 77, month, days % 28 + 1, seconds / 3600 % 24, seconds / 60 % 60, seconds % 60};
+    char* position = &telegram[offset];
+    for (const auto& part : parts) {
+      *position++ = static_cast<char>('0' + part / 10);
+      *position++ = static_cast<char>('0' + part % 10);
+    }
+    *position = month >= 4 && month <= 10 ? 'S' : 'W';
+  }
+
+  // The telegram ends with "!XXXX\r\n". The CRC covers everything from '/' up to and including '!'.
+  void WriteCrc(std::string& data) const {
+    static const char hexDigits[] = "0123456789ABCDEF";
+    const auto& endSymbolPosition = data.size() - 7;
+    const auto& crc = CalculateCrc16(data.data(), endSymbolPosition + 1);
+    for (int i = 0; i < 4; i++) {
+      data[endSymbolPosition + 1 + i] = hexDigits[(crc >> (12 - 4 * i)) & 0xF];
+    }
+  }
+
+  [[nodiscard]] size_t EndSymbolPosition() const { return telegram.size() - 7; }
+
+  // Never produces '/' or '!', so the packet boundaries stay intact and only the CRC check can reject the telegram
+  StringView FlipBit() {
+    corrupted = telegram;
+    const auto& position = 1 + Random() % (EndSymbolPosition() - 1);
+    auto bit = Random() % 7;
+    while (static_cast<char>(corrupted[position] ^ (1 << bit)) == '/' || static_cast<char>(corrupted[position] ^ (1 << bit)) == '!') {
+      bit = (bit + 1) % 7;
+    }
+    corrupted[position] = static_cast<char>(corrupted[position] ^ (1 << bit));
+    return StringView(corrupted.data(), corrupted.size());
+  }
+
+  StringView Truncate() {
+    const auto& size = 1 + Random() % (EndSymbolPosition() + 4);
+    return StringView(telegram.data(), size);
+  }
+
+  // The receiver restarts on the stray '/' and checks the rest of the telegram against the original CRC.
+  // It is never inserted right after the real one, otherwise the rest would be the original telegram, and a position is drawn again
+  // in the rare case the CRC of the rest matches the original one.
+  StringView InsertStrayStartSymbol() {
+    const auto& crcLength = EndSymbolPosition() + 1;
+    const auto& crc = CalculateCrc16(telegram.data(), crcLength);
+    const char startSymbol = '/';
+    size_t position;
+    do {
+      position = 2 + Random() % (EndSymbolPosition() - 2);
+    } while (AddToCrc16(AddToCrc16(0, &startSymbol, 1), &telegram[position], crcLength - position) == crc);
+
+    corrupted = telegram;
+    corrupted.insert(position, 1, '/');
+    return StringView(corrupted.data(), corrupted.size());
+  }
+
+  StringView MakeOversize() {
+    static const char filler[] = "0-0:96.13.0(48656C6C6F20576F726C6421)\r\n";
+    corrupted.assign(telegram, 0, EndSymbolPosition());
+    while (corrupted.size() <= config.oversizeFrameSize) {
+      corrupted.append(filler);
+    }
+    corrupted.append(telegram, EndSymbolPosition(), std::string::npos);
+    WriteCrc(corrupted);
+    return StringView(corrupted.data(), corrupted.size());
+  }
+
+  // xorshift32
+  uint32_t Random() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+  }
+};
+
+}
@@ -0,0 +1,125 @@
+#include "DsmrTelegramGenerator.h"
+#include <cstdio>
+#include <doctest.h>
+using namespace DsmrParser;
+
+class DsmrParserResultCounter : public IDsmrParserResultReceiver {
+public:
+  size_t count = 0;
+
+  void OnDsmrData(const DsmrDataObject& /* dsmrData */) override { count++; }
+};
+
+static size_t CountReceivedPackets(DsmrPacketReceiver<4000>& receiver, const StringView& data) {
+  size_t packetsReceived = 0;
+  for (size_t i = 0; i < data.Size(); i++) {
+    if (receiver.ProcessByte(data.Data()[i]) != nullptr) {
+      packetsReceived++;
+    }
+  }
+  return packetsReceived;
+}
+
+TEST_CASE("DsmrTelegramGenerator") {
+  DsmrTelegramGeneratorConfig config;
+  config.mbusChannels = 2;
+  config.powerFailures = 10;
+  DsmrPacketReceiver<4000> receiver;
+
+  SUBCASE("Generated telegrams are received and parsed") {
+    for (const auto& headerStyle :
+         {VendorHeaderStyle::Kaifa, VendorHeaderStyle::Iskra, VendorHeaderStyle::LandisGyr, VendorHeaderStyle::Sagemcom}) {
+      config.headerStyle = headerStyle;
+      DsmrTelegramGenerator generator(config);
+      DsmrParserResultCounter resultCounter;
+      DsmrPacketParser parser(resultCounter);
+
+      for (int i = 0; i < 100; i++) {
+        const auto& telegram = generator.Next();
+        const IPacket* packet = nullptr;
+        for (size_t j = 0; j < telegram.Size(); j++) {
+          const auto& result = receiver.ProcessByte(telegram.Data()[j]);
+          if (result != nullptr) {
+            packet = result;
+          }
+        }
+        REQUIRE(packet != nullptr);
+
+        DsmrPacketHeader header;
+        REQUIRE(parser.ParseHeader(*packet, header) == true);
+
+        resultCounter.count = 0;
+        parser.Parse(*packet);
+        REQUIRE(resultCounter.count == generator.ParsableObjectCount());
+      }
+    }
+  }
+
+  SUBCASE("CRC matches CalculateCrc16") {
+    DsmrTelegramGenerator generator(config);
+    const char hexDigits[] = "0123456789ABCDEF";
+
+    for (int i = 0; i < 100; i++) {
+      const auto& telegram = generator.Next();
+      const auto& crcLength = telegram.Size() - 6;
+      const auto& crc = CalculateCrc16(telegram.Data(), crcLength);
+      REQUIRE(generator.CalculateCrc16(telegram.Data(), crcLength) == crc);
+      REQUIRE(telegram.Data()[crcLength + 0] == hexDigits[(crc >> 12) & 0xF]);
+      REQUIRE(telegram.Data()[crcLength + 1] == hexDigits[(crc >> 8) & 0xF]);
+      REQUIRE(telegram.Data()[crcLength + 2] == hexDigits[(crc >> 4) & 0xF]);
+      REQUIRE(telegram.Data()[crcLength + 3] == hexDigits[crc & 0xF]);
+    }
+
+    const char nonAsciiData[] = "/\x80\x81\xFF data with non ASCII bytes \xC3\xA9!";
+    REQUIRE(generator.CalculateCrc16(nonAsciiData, sizeof(nonAsciiData) - 1) == CalculateCrc16(nonAsciiData, sizeof(nonAsciiData) - 1));
+  }
+
+  SUBCASE("Corrupted telegrams are rejected") {
+    DsmrTelegramGenerator generator(config);
+
+    for (const auto& corruption : {TelegramCorruption::BitFlip, TelegramCorruption::Truncation, TelegramCorruption::StrayStartSymbol,
+                                   TelegramCorruption::Oversize}) {
+      for (int i = 0; i < 100; i++) {
+        REQUIRE(CountReceivedPackets(receiver, generator.Next(corruption)) == 0);
+        REQUIRE(CountReceivedPackets(receiver, generator.Next()) == 1);
+      }
+    }
+  }
+
+  SUBCASE("Oversized telegram has a valid CRC") {
+    config.oversizeFrameSize = 5000;
+    DsmrTelegramGenerator generator(config);
+    DsmrPacketReceiver<6000> largeReceiver;
+
+    const auto& telegram = generator.Next(TelegramCorruption::Oversize);
+    REQUIRE(telegram.Size() > 5000);
+
+    size_t packetsReceived = 0;
+    for (size_t i = 0; i < telegram.Size(); i++) {
+      if (largeReceiver.ProcessByte(telegram.Data()[i]) != nullptr) {
+        packetsReceived++;
+      }
+    }
+    REQUIRE(packetsReceived == 1);
+  }
+
+  SUBCASE("Stream telegrams to a file") {
+    DsmrTelegramGenerator generator(config);
+    FILE* file = tmpfile();
+    REQUIRE(file != nullptr);
+    FileTelegramSink sink(file);
+
+    REQUIRE(generator.Write(sink, 100, 4, TelegramCorruption::BitFlip) == true);
+    REQUIRE(generator.Sequence() == 100);
+
+    rewind(file);
+    size_t packetsReceived = 0;
+    for (int byte = fgetc(file); byte != EOF; byte = fgetc(file)) {
+      if (receiver.ProcessByte(static_cast<char>(byte)) != nullptr) {
+        packetsReceived++;
+      }
+    }
+    fclose(file);
+    REQUIRE(packetsReceived == 75);
+  }
+}